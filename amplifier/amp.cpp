@@ -2,9 +2,13 @@
 #include <portaudio.h>
 #include <atomic>
 #include <thread>
+#include <functional>
 #include <cmath>
 #include <termios.h>
+#include <poll.h>
 #include <unistd.h>
+#include "../common/audio_io.h"
+#include "amp_dsp.h"
 
 #define SAMPLE_RATE 44100  
 #define FRAMES_PER_BUFFER 256  
@@ -13,38 +17,15 @@ std::atomic<float> gain(2.0f);
 std::atomic<float> volume(1.0f);  
 std::atomic<float> noiseThreshold(0.005f);  // Bisa diatur saat runtime
 
-// Fungsi membaca keyboard tanpa ENTER (Linux)
-char getKeyPress() {
-    struct termios oldt, newt;
-    char ch;
-    tcgetattr(STDIN_FILENO, &oldt);
-    newt = oldt;
-    newt.c_lflag &= ~(ICANON | ECHO);
-    tcsetattr(STDIN_FILENO, TCSANOW, &newt);
-    ch = getchar();
-    tcsetattr(STDIN_FILENO, TCSANOW, &oldt);
-    return ch;
-}
-
-// **Noise Gate dengan Attack-Release**
-float noiseGate(float sample, float threshold, float release = 0.99f) {
-    static float gateLevel = 0.0f;
-    if (fabs(sample) > threshold) {
-        gateLevel = 1.0f;  // Biarkan suara masuk
-    } else {
-        gateLevel *= release;  // Perlahan-lahan turunkan noise
+// Fungsi membaca keyboard tanpa ENTER (Linux), terminal harus sudah non-canonical.
+// Mengembalikan 0 jika tidak ada tombol dalam timeoutMs.
+char getKeyPress(int timeoutMs) {
+    struct pollfd fd = {STDIN_FILENO, POLLIN, 0};
+    char ch = 0;
+    if (poll(&fd, 1, timeoutMs) > 0 && read(STDIN_FILENO, &ch, 1) != 1) {
+        ch = 'q';  // EOF pada stdin: keluar
     }
-    return sample * gateLevel;
-}
-
-// **Low-Pass Filter** (mengurangi noise frekuensi tinggi)
-float lowPassFilter(float input, float previous, float alpha = 0.1f) {
-    return alpha * input + (1 - alpha) * previous;
-}
-
-// **High-Pass Filter** (mengurangi hum frekuensi rendah)
-float highPassFilter(float input, float previous, float alpha = 0.9f) {
-    return alpha * (previous + input - previous);
+    return ch;
 }
 
 // **Callback Audio PortAudio**
@@ -56,35 +37,31 @@ static int audioCallback(const void* inputBuffer, void* outputBuffer,
 {
     float* in  = (float*)inputBuffer;
     float* out = (float*)outputBuffer;
-    static float prevSample = 0.0f;
+    AmpState* state = (AmpState*)userData;
 
     if (inputBuffer == nullptr) return paContinue;
 
-    for (unsigned int i = 0; i < framesPerBuffer; i++) {
-        float sample = in[i];
-
-        // **Noise Gate**
-        sample = noiseGate(sample, noiseThreshold.load());
-
-        // **Low-Pass & High-Pass Filtering**
-        sample = lowPassFilter(sample, prevSample);
-        sample = highPassFilter(sample, prevSample);
-        prevSample = sample;
-
-        // **Amplifikasi**
-        out[i] = sample * gain.load() * volume.load();
-        if (out[i] > 1.0f) out[i] = 1.0f;  
-        if (out[i] < -1.0f) out[i] = -1.0f;
-    }
+    float threshold = noiseThreshold.load();
+    float totalGain = gain.load();
+    float totalVolume = volume.load();
+    dispatchBlockSize(framesPerBuffer, [&](auto frames) {
+        processAmpBlock(in, out, frames, threshold, totalGain, totalVolume, *state);
+    });
 
     return paContinue;
 }
 
 // **Thread untuk mengontrol gain, volume, dan noise threshold**
-void controlThread() {
+void controlThread(const AudioBackend& audio) {
+    struct termios oldt, newt;
+    tcgetattr(STDIN_FILENO, &oldt);
+    newt = oldt;
+    newt.c_lflag &= ~(ICANON | ECHO);
+    tcsetattr(STDIN_FILENO, TCSANOW, &newt);
+
     char ch;
     while (true) {
-        ch = getKeyPress();
+        ch = getKeyPress(100);  // Tanpa tombol pun, status digambar ulang tiap 100ms
         if (ch == '+') gain.store(gain.load() + 0.1f);
         else if (ch == '-') gain.store(gain.load() - 0.1f);
         else if (ch == '[') volume.store(volume.load() - 0.1f);
@@ -94,30 +71,43 @@ void controlThread() {
         else if (ch == 'q') break;
         std::cout << "\rGain: " << gain.load() 
                   << " | Volume: " << volume.load() 
-                  << " | Noise Gate: " << noiseThreshold.load() << "   " << std::flush;
+                  << " | Noise Gate: " << noiseThreshold.load()
+                  << " | " << audio.statusLine() << "   " << std::flush;
     }
+
+    tcsetattr(STDIN_FILENO, TCSANOW, &oldt);
 }
 
 int main() {
-    Pa_Initialize();
-
-    PaStream* stream;
-    Pa_OpenDefaultStream(&stream,
-                         1, 1,  
-                         paFloat32, SAMPLE_RATE, FRAMES_PER_BUFFER,
-                         audioCallback, nullptr);
+    auto audio = createAudioBackend();
+
+    AudioStreamConfig config;
+    config.inputChannels = 1;
+    config.outputChannels = 1;
+    config.sampleRate = SAMPLE_RATE;
+    config.framesPerBuffer = FRAMES_PER_BUFFER;
+    configureFromEnvironment(config);
+
+    AmpState state;
+    if (!audio->open(config, audioCallback, &state) || !audio->start()) {
+        std::cerr << "Error membuka stream: " << audio->errorText() << "\n";
+        return 1;
+    }
+    std::cout << config.sampleRate << " Hz, " << config.framesPerBuffer << " frame per blok\n";
 
-    Pa_StartStream(stream);
-    std::cout << "Amplifier berjalan... Tekan '+/-' untuk gain, '[ ]' untuk volume, '{ }' untuk noise gate, 'q' untuk keluar.\n";
+    if (audio->isHeadless()) {
+        std::cout << "Amplifier berjalan tanpa sound card...\n";
+        waitForStream(*audio);
+    } else {
+        std::cout << "Amplifier berjalan... Tekan '+/-' untuk gain, '[ ]' untuk volume, '{ }' untuk noise gate, 'q' untuk keluar.\n";
 
-    std::thread control(controlThread);
-    control.join();
+        std::thread control(controlThread, std::cref(*audio));
+        control.join();
+    }
 
-    Pa_StopStream(stream);
-    Pa_CloseStream(stream);
-    Pa_Terminate();
+    audio->stop();
+    audio->close();
 
-    std::cout << "\nAmplifier dihentikan." << std::endl;
+    std::cout << "\nAmplifier dihentikan.\n" << audio->statsReport() << std::flush;
     return 0;
 }
-
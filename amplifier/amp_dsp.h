@@ -0,0 +1,67 @@
+#pragma once
+
+// DSP amp.cpp: dipakai oleh callback dan oleh bench/bench.cpp
+#include <algorithm>
+#include <cmath>
+#include "../common/block_size.h"
+
+// **Noise Gate dengan Attack-Release** (gateLevel dibawa antar sampel oleh pemanggil)
+inline float noiseGate(float sample, float threshold, float& gateLevel, float release = 0.99f) {
+    if (fabs(sample) > threshold) {
+        gateLevel = 1.0f;  // Biarkan suara masuk
+    } else {
+        gateLevel *= release;  // Perlahan-lahan turunkan noise
+    }
+    return sample * gateLevel;
+}
+
+// **Low-Pass Filter** (mengurangi noise frekuensi tinggi)
+inline float lowPassFilter(float input, float previous, float alpha = 0.1f) {
+    return alpha * input + (1 - alpha) * previous;
+}
+
+// **High-Pass Filter** (mengurangi hum frekuensi rendah)
+inline float highPassFilter(float input, float previous, float alpha = 0.9f) {
+    return alpha * (previous + input - previous);
+}
+
+// State amp yang dibawa dari satu blok ke blok berikutnya
+struct AmpState {
+    float gateLevel = 0.0f;
+    float prevSample = 0.0f;
+};
+
+// **Rantai amp lengkap untuk satu blok** (Frames: lihat common/block_size.h)
+//
+// State disalin ke variabel lokal selama satu blok supaya tetap di register, dan
+// tahap tanpa state (gain + clipping) dipisah ke loop sendiri: loop itu tidak
+// punya dependensi antar sampel, jadi dengan FixedBlock bisa di-unroll dan
+// divektorisasi tanpa sisa loop.
+template <typename Frames>
+inline void processAmpBlock(const float* in, float* out, Frames frames,
+                            float threshold, float gain, float volume, AmpState& state) {
+    const unsigned long count = frames;  // Konstanta compile-time untuk FixedBlock
+    float gateLevel = state.gateLevel;
+    float prevSample = state.prevSample;
+    for (unsigned long i = 0; i < count; i++) {
+        float sample = in[i];
+
+        // **Noise Gate**
+        sample = noiseGate(sample, threshold, gateLevel);
+
+        // **Low-Pass & High-Pass Filtering**
+        sample = lowPassFilter(sample, prevSample);
+        sample = highPassFilter(sample, prevSample);
+        prevSample = sample;
+        out[i] = sample;
+    }
+    state.gateLevel = gateLevel;
+    state.prevSample = prevSample;
+
+    // **Amplifikasi**
+    const float totalGain = gain * volume;
+#pragma GCC unroll 8
+    for (unsigned long i = 0; i < count; i++) {
+        out[i] = std::max(-1.0f, std::min(1.0f, out[i] * totalGain));
+    }
+}
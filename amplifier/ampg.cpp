@@ -4,80 +4,19 @@
 #include <portaudio.h>
 #include <sndfile.h>
 #include <ncurses.h>
+#include "../common/audio_io.h"
+#include "ampg_dsp.h"
 
 #define SAMPLE_RATE 44100
 #define FRAMES_PER_BUFFER 256
-#define MAX_DELAY 44100  // 1 detik delay (44100 sampel)
 #define MAX_GAIN 2.0f
-#define FLANGER_DEPTH 5  // Kedalaman flanger dalam ms
-#define CHORUS_DEPTH 10  // Kedalaman chorus dalam ms
-#define LFO_RATE 0.5f    // Frekuensi LFO dalam Hz
-
-struct AudioData {
-    std::vector<float> delayBuffer;
-    std::vector<float> flangerBuffer;
-    std::vector<float> chorusBuffer;
-    size_t delayIndex = 0;
-    size_t flangerIndex = 0;
-    size_t chorusIndex = 0;
-    float gain = 1.0f;
-    float delayMix = 0.3f;
-    float reverbMix = 0.2f;
-    float flangerMix = 0.2f;
-    float chorusMix = 0.2f;
+
+struct AudioData : EffectState {
     bool recording = true;
-    float lfoPhase = 0.0f;
     SNDFILE *outfile;
     SF_INFO sfinfo;
 };
 
-// Efek distorsi (clipping)
-float applyDistortion(float sample, float drive) {
-    sample *= drive;
-    return std::max(-1.0f, std::min(1.0f, sample));
-}
-
-// Efek delay (echo)
-float applyDelay(AudioData &data, float sample) {
-    float delayedSample = data.delayBuffer[data.delayIndex];
-    data.delayBuffer[data.delayIndex] = sample;
-    data.delayIndex = (data.delayIndex + 1) % MAX_DELAY;
-    return sample + delayedSample * data.delayMix;
-}
-
-// Efek reverb sederhana
-float applyReverb(float sample, float reverbMix) {
-    return sample * (1.0f - reverbMix) + (sample * reverbMix * 0.5f);
-}
-
-// Efek flanger (delay dengan LFO)
-float applyFlanger(AudioData &data, float sample) {
-    int delaySamples = (FLANGER_DEPTH * SAMPLE_RATE) / 1000;
-    int lfoOffset = static_cast<int>((sin(data.lfoPhase) + 1) * 0.5 * delaySamples);
-    int index = (data.flangerIndex + MAX_DELAY - lfoOffset) % MAX_DELAY;
-
-    float delayedSample = data.flangerBuffer[index];
-    data.flangerBuffer[data.flangerIndex] = sample;
-    data.flangerIndex = (data.flangerIndex + 1) % MAX_DELAY;
-    data.lfoPhase += (2 * M_PI * LFO_RATE) / SAMPLE_RATE;
-
-    return sample + delayedSample * data.flangerMix;
-}
-
-// Efek chorus (pitch shifting delay dengan LFO)
-float applyChorus(AudioData &data, float sample) {
-    int delaySamples = (CHORUS_DEPTH * SAMPLE_RATE) / 1000;
-    int lfoOffset = static_cast<int>((sin(data.lfoPhase) + 1) * 0.5 * delaySamples);
-    int index = (data.chorusIndex + MAX_DELAY - lfoOffset) % MAX_DELAY;
-
-    float delayedSample = data.chorusBuffer[index];
-    data.chorusBuffer[data.chorusIndex] = sample;
-    data.chorusIndex = (data.chorusIndex + 1) % MAX_DELAY;
-    data.lfoPhase += (2 * M_PI * (LFO_RATE / 2)) / SAMPLE_RATE;  // Lebih lambat dari flanger
-
-    return sample + delayedSample * data.chorusMix;
-}
-
 // Callback audio
 static int audioCallback(const void *inputBuffer, void *outputBuffer,
                          unsigned long framesPerBuffer,
@@ -88,28 +27,18 @@ static int audioCallback(const void *inputBuffer, void *outputBuffer,
     const float *in = (const float *)inputBuffer;
     float *out = (float *)outputBuffer;
 
-    for (unsigned long i = 0; i < framesPerBuffer; i++) {
-        float sample = in[i] * data->gain;
-
-        // Terapkan efek
-        sample = applyDistortion(sample, 2.0f);
-        sample = applyDelay(*data, sample);
-        sample = applyFlanger(*data, sample);
-        sample = applyChorus(*data, sample);
-        sample = applyReverb(sample, data->reverbMix);
-
-        out[i] = sample;
+    processEffectBlock(*data, in, out, framesPerBuffer);
 
-        // Simpan ke file jika recording aktif
-        if (data->recording) {
-            sf_write_float(data->outfile, &sample, 1);
-        }
+    // Simpan ke file jika recording aktif
+    if (data->recording) {
+        sf_write_float(data->outfile, out, framesPerBuffer);
     }
 
     return paContinue;
 }
 
-void showUI(float gain, float delayMix, float reverbMix, float flangerMix, float chorusMix) {
+void showUI(float gain, float delayMix, float reverbMix, float flangerMix, float chorusMix,
+            const std::string& status) {
     clear();
     printw("Guitar Amp Live - CLI UI\n");
     printw("========================\n");
@@ -119,53 +48,72 @@ void showUI(float gain, float delayMix, float reverbMix, float flangerMix, float
     printw("Flanger : %.1f (R/F to adjust)\n", flangerMix);
     printw("Chorus  : %.1f (T/G to adjust)\n", chorusMix);
     printw("ESC to stop recording.\n");
+    printw("\n%s\n", status.c_str());
     refresh();
 }
 
 int main() {
-    Pa_Initialize();
-    initscr();
-    cbreak();
-    noecho();
-    timeout(100);
+    auto audio = createAudioBackend();
 
     AudioData data;
-    data.delayBuffer.resize(MAX_DELAY, 0.0f);
-    data.flangerBuffer.resize(MAX_DELAY, 0.0f);
-    data.chorusBuffer.resize(MAX_DELAY, 0.0f);
 
-    data.sfinfo.samplerate = SAMPLE_RATE;
+    AudioStreamConfig config;
+    config.inputChannels = 1;
+    config.outputChannels = 1;
+    config.sampleRate = SAMPLE_RATE;
+    config.framesPerBuffer = FRAMES_PER_BUFFER;
+    configureFromEnvironment(config);
+
+    if (!audio->open(config, audioCallback, &data)) {
+        std::cerr << "Error opening stream: " << audio->errorText() << "\n";
+        return 1;
+    }
+
+    // Buffer efek dan file rekaman mengikuti sample rate hasil negosiasi
+    data.setSampleRate(config.sampleRate);
+    data.sfinfo.samplerate = static_cast<int>(config.sampleRate);
     data.sfinfo.channels = 1;
     data.sfinfo.format = SF_FORMAT_WAV | SF_FORMAT_PCM_16;
     data.outfile = sf_open("guitar_amp_output.wav", SFM_WRITE, &data.sfinfo);
 
-    PaStream *stream;
-    Pa_OpenDefaultStream(&stream, 1, 1, paFloat32, SAMPLE_RATE, FRAMES_PER_BUFFER, audioCallback, &data);
-    Pa_StartStream(stream);
-
-    int ch;
-    while ((ch = getch()) != 27) {  // ESC untuk keluar
-        if (ch == 'w') data.gain = std::min(data.gain + 0.1f, MAX_GAIN);
-        if (ch == 's') data.gain = std::max(data.gain - 0.1f, 0.1f);
-        if (ch == 'a') data.delayMix = std::max(data.delayMix - 0.1f, 0.0f);
-        if (ch == 'd') data.delayMix = std::min(data.delayMix + 0.1f, 1.0f);
-        if (ch == 'q') data.reverbMix = std::max(data.reverbMix - 0.1f, 0.0f);
-        if (ch == 'e') data.reverbMix = std::min(data.reverbMix + 0.1f, 1.0f);
-        if (ch == 'r') data.flangerMix = std::min(data.flangerMix + 0.1f, 1.0f);
-        if (ch == 'f') data.flangerMix = std::max(data.flangerMix - 0.1f, 0.0f);
-        if (ch == 't') data.chorusMix = std::min(data.chorusMix + 0.1f, 1.0f);
-        if (ch == 'g') data.chorusMix = std::max(data.chorusMix - 0.1f, 0.0f);
-        showUI(data.gain, data.delayMix, data.reverbMix, data.flangerMix, data.chorusMix);
+    if (!audio->start()) {
+        std::cerr << "Error starting stream: " << audio->errorText() << "\n";
+        sf_close(data.outfile);
+        return 1;
+    }
+
+    if (audio->isHeadless()) {
+        waitForStream(*audio);
+    } else {
+        initscr();
+        cbreak();
+        noecho();
+        timeout(100);
+
+        int ch;
+        while ((ch = getch()) != 27) {  // ESC untuk keluar
+            if (ch == 'w') data.gain = std::min(data.gain + 0.1f, MAX_GAIN);
+            if (ch == 's') data.gain = std::max(data.gain - 0.1f, 0.1f);
+            if (ch == 'a') data.delayMix = std::max(data.delayMix - 0.1f, 0.0f);
+            if (ch == 'd') data.delayMix = std::min(data.delayMix + 0.1f, 1.0f);
+            if (ch == 'q') data.reverbMix = std::max(data.reverbMix - 0.1f, 0.0f);
+            if (ch == 'e') data.reverbMix = std::min(data.reverbMix + 0.1f, 1.0f);
+            if (ch == 'r') data.flangerMix = std::min(data.flangerMix + 0.1f, 1.0f);
+            if (ch == 'f') data.flangerMix = std::max(data.flangerMix - 0.1f, 0.0f);
+            if (ch == 't') data.chorusMix = std::min(data.chorusMix + 0.1f, 1.0f);
+            if (ch == 'g') data.chorusMix = std::max(data.chorusMix - 0.1f, 0.0f);
+            showUI(data.gain, data.delayMix, data.reverbMix, data.flangerMix, data.chorusMix,
+                   audio->statusLine());
+        }
+
+        endwin();
     }
 
     data.recording = false;
-    Pa_StopStream(stream);
-    Pa_CloseStream(stream);
+    audio->stop();
+    audio->close();
     sf_close(data.outfile);
 
-    endwin();
-    Pa_Terminate();
-    std::cout << "Recording saved as 'guitar_amp_output.wav'\n";
+    std::cout << "Recording saved as 'guitar_amp_output.wav'\n" << audio->statsReport();
     return 0;
 }
-
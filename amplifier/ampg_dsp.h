@@ -0,0 +1,163 @@
+#pragma once
+
+// DSP ampg.cpp: dipakai oleh callback dan oleh bench/bench.cpp
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#define MAX_DELAY_MS 1000  // 1 detik delay
+#define FLANGER_DEPTH 5    // Kedalaman flanger dalam ms
+#define CHORUS_DEPTH 10    // Kedalaman chorus dalam ms
+#define LFO_RATE 0.5f      // Frekuensi LFO dalam Hz
+
+struct EffectState {
+    explicit EffectState(double sampleRate = 44100) { setSampleRate(sampleRate); }
+
+    // Semua panjang delay dihitung dari ms, jadi benar di sample rate berapa pun
+    void setSampleRate(double rate) {
+        sampleRate = rate;
+        maxDelay = static_cast<size_t>(MAX_DELAY_MS * rate / 1000);
+        flangerDelaySamples = static_cast<int>(FLANGER_DEPTH * rate / 1000);
+        chorusDelaySamples = static_cast<int>(CHORUS_DEPTH * rate / 1000);
+        flangerLfoStep = static_cast<float>((2 * M_PI * LFO_RATE) / rate);
+        chorusLfoStep = static_cast<float>((2 * M_PI * (LFO_RATE / 2)) / rate);  // Lebih lambat dari flanger
+        delayBuffer.assign(maxDelay, 0.0f);
+        flangerBuffer.assign(maxDelay, 0.0f);
+        chorusBuffer.assign(maxDelay, 0.0f);
+        delayIndex = flangerIndex = chorusIndex = 0;
+    }
+
+    double sampleRate = 0;
+    size_t maxDelay = 0;
+    int flangerDelaySamples = 0;
+    int chorusDelaySamples = 0;
+    float flangerLfoStep = 0.0f;
+    float chorusLfoStep = 0.0f;
+
+    std::vector<float> delayBuffer;
+    std::vector<float> flangerBuffer;
+    std::vector<float> chorusBuffer;
+    size_t delayIndex = 0;
+    size_t flangerIndex = 0;
+    size_t chorusIndex = 0;
+    float gain = 1.0f;
+    float delayMix = 0.3f;
+    float reverbMix = 0.2f;
+    float flangerMix = 0.2f;
+    float chorusMix = 0.2f;
+    float lfoPhase = 0.0f;
+};
+
+// Tulis sample ke ring buffer sepanjang maxDelay dan kembalikan sampel yang
+// `offset` posisi di belakang posisi tulis (offset 0 = sampel tertua, maxDelay
+// sampel yang lalu). Index dan buffer dioper eksplisit supaya rantai blok bisa
+// memakai salinan lokal.
+inline float ringTap(float* buffer, size_t maxDelay, size_t& index, int offset, float sample) {
+    size_t readIndex = index >= static_cast<size_t>(offset) ? index - offset : index + maxDelay - offset;
+    float delayedSample = buffer[readIndex];
+    buffer[index] = sample;
+    if (++index == maxDelay) index = 0;  // Tanpa modulo: maxDelay tidak lagi konstanta
+    return delayedSample;
+}
+
+// Offset delay dari LFO sinus, 0..depthSamples
+inline int lfoOffset(float phase, int depthSamples) {
+    return static_cast<int>((sin(phase) + 1) * 0.5 * depthSamples);
+}
+
+// Efek distorsi (clipping)
+inline float applyDistortion(float sample, float drive) {
+    sample *= drive;
+    return std::max(-1.0f, std::min(1.0f, sample));
+}
+
+// Efek delay (echo)
+inline float applyDelay(EffectState &data, float sample) {
+    float delayedSample = ringTap(data.delayBuffer.data(), data.maxDelay, data.delayIndex, 0, sample);
+    return sample + delayedSample * data.delayMix;
+}
+
+// Efek reverb sederhana
+inline float applyReverb(float sample, float reverbMix) {
+    return sample * (1.0f - reverbMix) + (sample * reverbMix * 0.5f);
+}
+
+// Efek flanger (delay dengan LFO)
+inline float applyFlanger(EffectState &data, float sample) {
+    float delayedSample = ringTap(data.flangerBuffer.data(), data.maxDelay, data.flangerIndex,
+                                  lfoOffset(data.lfoPhase, data.flangerDelaySamples), sample);
+    data.lfoPhase += data.flangerLfoStep;
+    return sample + delayedSample * data.flangerMix;
+}
+
+// Efek chorus (pitch shifting delay dengan LFO)
+inline float applyChorus(EffectState &data, float sample) {
+    float delayedSample = ringTap(data.chorusBuffer.data(), data.maxDelay, data.chorusIndex,
+                                  lfoOffset(data.lfoPhase, data.chorusDelaySamples), sample);
+    data.lfoPhase += data.chorusLfoStep;
+    return sample + delayedSample * data.chorusMix;
+}
+
+// Rantai efek lengkap untuk satu sampel
+inline float processEffectSample(EffectState &data, float sample) {
+    sample *= data.gain;
+
+    // Terapkan efek
+    sample = applyDistortion(sample, 2.0f);
+    sample = applyDelay(data, sample);
+    sample = applyFlanger(data, sample);
+    sample = applyChorus(data, sample);
+    sample = applyReverb(sample, data.reverbMix);
+    return sample;
+}
+
+// Rantai efek untuk satu blok, hasilnya sama dengan processEffectSample per
+// sampel. Gain + distorsi dan reverb tidak punya state, jadi masing-masing loop
+// sendiri yang bisa divektorisasi; delay, flanger, dan chorus bekerja pada
+// salinan lokal index dan fase LFO. Tidak memakai fast path FixedBlock: sin()
+// per sampel di flanger/chorus mendominasi, bench tidak menunjukkan selisih.
+inline void processEffectBlock(EffectState &data, const float* in, float* out, unsigned long count) {
+    const float gain = data.gain;
+    for (unsigned long i = 0; i < count; i++) {
+        out[i] = applyDistortion(in[i] * gain, 2.0f);
+    }
+
+    float* delayBuffer = data.delayBuffer.data();
+    float* flangerBuffer = data.flangerBuffer.data();
+    float* chorusBuffer = data.chorusBuffer.data();
+    const size_t maxDelay = data.maxDelay;
+    const float delayMix = data.delayMix;
+    const float flangerMix = data.flangerMix;
+    const float chorusMix = data.chorusMix;
+    const int flangerDelaySamples = data.flangerDelaySamples;
+    const int chorusDelaySamples = data.chorusDelaySamples;
+    const float flangerLfoStep = data.flangerLfoStep;
+    const float chorusLfoStep = data.chorusLfoStep;
+    size_t delayIndex = data.delayIndex;
+    size_t flangerIndex = data.flangerIndex;
+    size_t chorusIndex = data.chorusIndex;
+    float lfoPhase = data.lfoPhase;
+    for (unsigned long i = 0; i < count; i++) {
+        float sample = out[i];
+        sample += ringTap(delayBuffer, maxDelay, delayIndex, 0, sample) * delayMix;
+
+        float delayedSample = ringTap(flangerBuffer, maxDelay, flangerIndex,
+                                      lfoOffset(lfoPhase, flangerDelaySamples), sample);
+        lfoPhase += flangerLfoStep;
+        sample += delayedSample * flangerMix;
+
+        delayedSample = ringTap(chorusBuffer, maxDelay, chorusIndex,
+                                lfoOffset(lfoPhase, chorusDelaySamples), sample);
+        lfoPhase += chorusLfoStep;
+        out[i] = sample + delayedSample * chorusMix;
+    }
+    data.delayIndex = delayIndex;
+    data.flangerIndex = flangerIndex;
+    data.chorusIndex = chorusIndex;
+    data.lfoPhase = lfoPhase;
+
+    const float reverbMix = data.reverbMix;
+    for (unsigned long i = 0; i < count; i++) {
+        out[i] = applyReverb(out[i], reverbMix);
+    }
+}
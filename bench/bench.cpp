@@ -0,0 +1,418 @@
+// Benchmark ns/sample dan real-time factor untuk setiap kernel DSP dan setiap
+// rantai lengkap (amp, ampg, mix, tuner). Untuk amp dan mix, blok 32-1024 memakai
+// fast path template (common/block_size.h) dan blok 480 jalur generik; keduanya
+// juga diukur sebagai "<rantai>.generic" yang selalu memakai jalur generik.
+//
+//   g++ -std=c++17 -O2 -o bench/bench bench/bench.cpp -lfftw3
+//   ./bench/bench [--seconds 1.0] [--thresholds bench/thresholds.txt]
+//                 [--baseline bench/baseline.jsonl] [--tolerance 1.0]
+//                 [--noise-floor 0.5] [--retries 3] [--strict]
+//
+// Hasil ditulis ke stdout sebagai JSON lines, satu baris per kernel/blok/sample rate:
+//   {"kernel":"ampg.flanger","block":256,"sample_rate":48000,"ns_per_sample":3.1,"rtf":6720.4}
+// Baris terakhir adalah overhead instrumentasi callback (common/rt_stats.h):
+//   {"kernel":"instrumentation","ns_per_callback":31.2}
+// Program keluar dengan status 1 jika:
+//   --baseline   : ada kernel/blok/sample rate yang lebih lambat dari baseline
+//                  (output bench sebelumnya) lebih dari --tolerance (default +100%)
+//                  DAN lebih dari --noise-floor ns/sample (default 0.5)
+//   --thresholds : ada batas absolut yang terlewati (ns/sample, atau ns/callback
+//                  untuk instrumentation)
+// Baris yang melewati batas diukur ulang (sampai --retries kali, default 3) dan
+// hanya gagal jika hasil terbaiknya tetap melewati batas. Baris tanpa entri
+// baseline maupun batas absolut, dan entri baseline yang kernelnya tidak diukur,
+// dilaporkan sebagai WARN, atau gagal dengan --strict.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../common/rt_stats.h"
+#include "../amplifier/amp_dsp.h"
+#include "../amplifier/ampg_dsp.h"
+#include "../mixer/mix_dsp.h"
+#include "../tuner-cli/tuner_dsp.h"
+
+typedef std::function<void(const float* in, float* out, unsigned long frames)> BlockFn;
+
+struct Kernel {
+    std::string name;
+    // Membuat state baru; totalFrames = jumlah sampel yang akan diproses
+    std::function<BlockFn(size_t totalFrames, double sampleRate)> make;
+};
+
+struct Result {
+    std::string kernel;
+    unsigned long block;
+    int sampleRate;
+    double nsPerSample;
+    double rtf;
+};
+
+static volatile float sink = 0.0f;
+
+// Kernel per sampel dibungkus menjadi loop per blok, lewat dispatch yang sama dengan callback
+template <typename State, typename Fn>
+static Kernel perSample(const std::string& name, Fn fn) {
+    return {name, [fn](size_t, double sampleRate) -> BlockFn {
+        auto state = std::make_shared<State>(sampleRate);
+        return [state, fn](const float* in, float* out, unsigned long frames) {
+            dispatchBlockSize(frames, [&](auto n) {
+                for (unsigned long i = 0; i < n; i++) out[i] = fn(*state, in[i]);
+            });
+        };
+    }};
+}
+
+struct NoState {
+    explicit NoState(double) {}
+};
+
+struct GateState {
+    explicit GateState(double) {}
+    float level = 0.0f;
+};
+
+struct FilterState {
+    explicit FilterState(double) {}
+    float prev = 0.0f;
+};
+
+// Rantai lengkap untuk satu blok. `name` lewat dispatchBlockSize seperti callback;
+// `name.generic` selalu memakai jalur unsigned long, sehingga keuntungan fast path
+// FixedBlock terlihat langsung dengan membandingkan kedua baris pada blok yang sama.
+template <typename MakeState, typename Fn>
+static void addBlockKernels(std::vector<Kernel>& kernels, const std::string& name, MakeState makeState, Fn fn) {
+    kernels.push_back({name, [makeState, fn](size_t totalFrames, double sampleRate) -> BlockFn {
+        auto state = makeState(totalFrames, sampleRate);
+        return [state, fn](const float* in, float* out, unsigned long frames) {
+            dispatchBlockSize(frames, [&](auto n) { fn(*state, in, out, n); });
+        };
+    }});
+    kernels.push_back({name + ".generic", [makeState, fn](size_t totalFrames, double sampleRate) -> BlockFn {
+        auto state = makeState(totalFrames, sampleRate);
+        return [state, fn](const float* in, float* out, unsigned long frames) {
+            fn(*state, in, out, frames);
+        };
+    }});
+}
+
+// Dipanggil sekali per window fftSize, terlepas dari ukuran blok
+template <typename Fn>
+static Kernel perWindow(const std::string& name, Fn fn) {
+    return {name, [fn](size_t, double sampleRate) -> BlockFn {
+        auto state = std::make_shared<TunerState>(sampleRate);
+        auto pending = std::make_shared<unsigned long>(0);
+        return [state, pending, fn](const float* in, float* out, unsigned long frames) {
+            *pending += frames;
+            while (*pending >= static_cast<unsigned long>(state->fftSize)) {
+                out[0] = fn(*state);
+                *pending -= state->fftSize;
+            }
+        };
+    }};
+}
+
+static std::vector<Kernel> allKernels() {
+    std::vector<Kernel> kernels;
+
+    // amp
+    kernels.push_back(perSample<GateState>("amp.noise_gate", [](GateState& g, float s) { return noiseGate(s, 0.005f, g.level); }));
+    kernels.push_back(perSample<FilterState>("amp.low_pass", [](FilterState& f, float s) { return f.prev = lowPassFilter(s, f.prev); }));
+    kernels.push_back(perSample<FilterState>("amp.high_pass", [](FilterState& f, float s) { return f.prev = highPassFilter(s, f.prev); }));
+    addBlockKernels(kernels, "amp",
+        [](size_t, double) { return std::make_shared<AmpState>(); },
+        [](AmpState& state, const float* in, float* out, auto n) {
+            processAmpBlock(in, out, n, 0.005f, 2.0f, 1.0f, state);
+        });
+
+    // ampg
+    kernels.push_back(perSample<NoState>("ampg.distortion", [](NoState&, float s) { return applyDistortion(s, 2.0f); }));
+    kernels.push_back(perSample<EffectState>("ampg.delay", [](EffectState& d, float s) { return applyDelay(d, s); }));
+    kernels.push_back(perSample<EffectState>("ampg.flanger", [](EffectState& d, float s) { return applyFlanger(d, s); }));
+    kernels.push_back(perSample<EffectState>("ampg.chorus", [](EffectState& d, float s) { return applyChorus(d, s); }));
+    kernels.push_back(perSample<NoState>("ampg.reverb", [](NoState&, float s) { return applyReverb(s, 0.2f); }));
+    kernels.push_back({"ampg", [](size_t, double sampleRate) -> BlockFn {
+        auto state = std::make_shared<EffectState>(sampleRate);
+        return [state](const float* in, float* out, unsigned long frames) {
+            processEffectBlock(*state, in, out, frames);
+        };
+    }});
+
+    // mix: dua buffer sepanjang seluruh pengukuran, disiapkan persis seperti mix.cpp (mono)
+    addBlockKernels(kernels, "mix",
+        [](size_t totalFrames, double) {
+            auto data = std::make_shared<MixerData>();
+            data->buffer1.assign(totalFrames, 0.25f);
+            data->buffer2.assign(totalFrames, -0.5f);
+            data->outputBuffer.reserve(data->buffer1.size());
+            return data;
+        },
+        [](MixerData& data, const float*, float* out, auto n) {
+            dispatchChannels(data.channels, [&](auto channels) { mixBlock(data, out, n, channels); });
+        });
+
+    // tuner
+    kernels.push_back({"tuner.collect", [](size_t, double sampleRate) -> BlockFn {
+        auto state = std::make_shared<TunerState>(sampleRate);
+        return [state](const float* in, float* out, unsigned long frames) {
+            out[0] = collectSamples(*state, in, frames) ? 1.0f : 0.0f;
+        };
+    }});
+    kernels.push_back(perWindow("tuner.fft_peak", [](const TunerState& s) { return detectPeakFrequency(s); }));
+    kernels.push_back(perWindow("tuner.note_lookup", [](const TunerState&) {
+        return (float)getClosestNoteWithOctave(110.0f).second;
+    }));
+    kernels.push_back({"tuner", [](size_t, double sampleRate) -> BlockFn {
+        auto state = std::make_shared<TunerState>(sampleRate);
+        return [state](const float* in, float* out, unsigned long frames) {
+            if (collectSamples(*state, in, frames)) {
+                float peakFrequency = detectPeakFrequency(*state);
+                out[0] = (float)getClosestNoteWithOctave(peakFrequency).second;
+            }
+        };
+    }});
+
+    return kernels;
+}
+
+// Sinyal uji deterministik: sinus 110 Hz + noise kecil (LCG)
+static std::vector<float> makeInput(size_t frames, int sampleRate) {
+    std::vector<float> input(frames);
+    unsigned int seed = 12345;
+    for (size_t i = 0; i < frames; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        float noise = ((seed >> 8) / 16777216.0f - 0.5f) * 0.01f;
+        input[i] = 0.5f * std::sin(2.0f * M_PI * 110.0f * i / sampleRate) + noise;
+    }
+    return input;
+}
+
+static Result measure(const Kernel& kernel, unsigned long block, int sampleRate, double seconds) {
+    const size_t blocks = std::max<size_t>(1, static_cast<size_t>(seconds * sampleRate) / block);
+    const size_t totalFrames = blocks * block;
+    const int repetitions = 15;
+
+    std::vector<float> input = makeInput(totalFrames, sampleRate);
+    std::vector<float> output(block, 0.0f);
+
+    double best = 1e300;
+    for (int r = 0; r <= repetitions; r++) {  // r == 0 untuk warm-up
+        BlockFn process = kernel.make(totalFrames, sampleRate);
+
+        auto start = std::chrono::steady_clock::now();
+        for (size_t b = 0; b < blocks; b++) {
+            process(input.data() + b * block, output.data(), block);
+        }
+        auto end = std::chrono::steady_clock::now();
+        sink = sink + output[0];
+
+        if (r > 0) best = std::min(best, std::chrono::duration<double>(end - start).count());
+    }
+
+    Result result;
+    result.kernel = kernel.name;
+    result.block = block;
+    result.sampleRate = sampleRate;
+    result.nsPerSample = best * 1e9 / totalFrames;
+    result.rtf = (static_cast<double>(totalFrames) / sampleRate) / best;
+    return result;
+}
+
+// Biaya yang ditambahkan AudioBackend ke setiap callback: dua kali
+// steady_clock::now() dan CallbackStats::record()
+static double measureInstrumentation() {
+    const int callbacks = 1000000;
+    CallbackStats stats;
+    stats.setDeadline(256.0 / 44100);
+
+    double best = 1e300;
+    for (int r = 0; r < 5; r++) {
+        auto begin = std::chrono::steady_clock::now();
+        for (int i = 0; i < callbacks; i++) {
+            auto start = std::chrono::steady_clock::now();
+            uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count();
+            stats.record(ns, 0);
+        }
+        auto end = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double>(end - begin).count());
+    }
+    sink = sink + stats.snapshot().p50Ns;
+    return best * 1e9 / callbacks;
+}
+
+// Format: "<kernel> <max ns/sample>" per baris, '#' untuk komentar
+static std::map<std::string, double> loadThresholds(const std::string& path) {
+    std::map<std::string, double> thresholds;
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "Error opening thresholds file " << path << std::endl;
+        std::exit(2);
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream fields(line);
+        std::string name;
+        double limit;
+        if (fields >> name >> limit) thresholds[name] = limit;
+    }
+    return thresholds;
+}
+
+static std::string baselineKey(const std::string& kernel, unsigned long block, int sampleRate) {
+    return kernel + " " + std::to_string(block) + " " + std::to_string(sampleRate);
+}
+
+// Ambil nilai field dari satu baris JSON yang ditulis program ini sendiri
+static std::string jsonField(const std::string& line, const std::string& name) {
+    std::string key = "\"" + name + "\":";
+    size_t pos = line.find(key);
+    if (pos == std::string::npos) return "";
+    pos += key.size();
+    if (line[pos] == '"') {
+        size_t end = line.find('"', pos + 1);
+        return line.substr(pos + 1, end - pos - 1);
+    }
+    size_t end = line.find_first_of(",}", pos);
+    return line.substr(pos, end - pos);
+}
+
+// Baseline = output bench sebelumnya; baris tanpa "block" (metadata, instrumentation) dilewati
+static std::map<std::string, double> loadBaseline(const std::string& path) {
+    std::map<std::string, double> baseline;
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "Error opening baseline file " << path << std::endl;
+        std::exit(2);
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+        std::string block = jsonField(line, "block");
+        if (block.empty()) continue;
+        baseline[baselineKey(jsonField(line, "kernel"), std::stoul(block), std::stoi(jsonField(line, "sample_rate")))] =
+            std::stod(jsonField(line, "ns_per_sample"));
+    }
+    return baseline;
+}
+
+int main(int argc, char* argv[]) {
+    double seconds = 1.0;
+    std::string thresholdsPath;
+    std::string baselinePath;
+    double tolerance = 1.0;
+    double noiseFloor = 0.5;
+    int retries = 3;
+    bool strict = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--seconds" && i + 1 < argc) {
+            seconds = std::atof(argv[++i]);
+        } else if (arg == "--thresholds" && i + 1 < argc) {
+            thresholdsPath = argv[++i];
+        } else if (arg == "--baseline" && i + 1 < argc) {
+            baselinePath = argv[++i];
+        } else if (arg == "--tolerance" && i + 1 < argc) {
+            tolerance = std::atof(argv[++i]);
+        } else if (arg == "--noise-floor" && i + 1 < argc) {
+            noiseFloor = std::atof(argv[++i]);
+        } else if (arg == "--retries" && i + 1 < argc) {
+            retries = std::atoi(argv[++i]);
+        } else if (arg == "--strict") {
+            strict = true;
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--seconds S] [--thresholds FILE] [--baseline FILE] [--tolerance R]"
+                      << " [--noise-floor NS] [--retries N] [--strict]" << std::endl;
+            return 2;
+        }
+    }
+
+    std::map<std::string, double> thresholds;
+    if (!thresholdsPath.empty()) thresholds = loadThresholds(thresholdsPath);
+    std::map<std::string, double> baseline;
+    if (!baselinePath.empty()) baseline = loadBaseline(baselinePath);
+
+    const unsigned long blockSizes[] = {32, 64, 128, 256, 480, 512, 1024};
+    const int sampleRates[] = {44100, 48000, 96000};
+
+    int failures = 0;
+    std::map<std::string, double> unmeasured = baseline;  // Entri baseline yang belum diukur
+    for (const Kernel& kernel : allKernels()) {
+        auto limit = thresholds.find(kernel.name);
+        for (int sampleRate : sampleRates) {
+            for (unsigned long block : blockSizes) {
+                auto reference = baseline.find(baselineKey(kernel.name, block, sampleRate));
+                unmeasured.erase(baselineKey(kernel.name, block, sampleRate));
+
+                // Batas relatif: lebih lambat dari --tolerance DAN lebih dari --noise-floor ns/sample
+                double baselineLimit = 0.0;
+                if (reference != baseline.end()) {
+                    baselineLimit = std::max(reference->second * (1.0 + tolerance), reference->second + noiseFloor);
+                }
+                // Batas paling ketat yang berlaku untuk baris ini, 0 = tidak di-gate
+                double allowed = baselineLimit;
+                if (limit != thresholds.end() && (allowed == 0.0 || limit->second < allowed)) allowed = limit->second;
+
+                // Ukur ulang baris yang melewati batas: gangguan scheduler hanya
+                // memperlambat, jadi hasil terbaik dari beberapa pengukuran dipakai
+                Result r = measure(kernel, block, sampleRate, seconds);
+                for (int retry = 0; allowed > 0.0 && r.nsPerSample > allowed && retry < retries; retry++) {
+                    Result again = measure(kernel, block, sampleRate, seconds);
+                    if (again.nsPerSample < r.nsPerSample) r = again;
+                }
+
+                std::cout << "{\"kernel\":\"" << r.kernel << "\",\"block\":" << r.block
+                          << ",\"sample_rate\":" << r.sampleRate
+                          << ",\"ns_per_sample\":" << r.nsPerSample
+                          << ",\"rtf\":" << r.rtf << "}" << std::endl;
+
+                if (limit != thresholds.end() && r.nsPerSample > limit->second) {
+                    std::cerr << "FAIL " << r.kernel << " block=" << r.block << " rate=" << r.sampleRate
+                              << ": " << r.nsPerSample << " ns/sample > " << limit->second << std::endl;
+                    failures++;
+                }
+
+                if (reference != baseline.end() && r.nsPerSample > baselineLimit) {
+                    std::cerr << "FAIL " << r.kernel << " block=" << r.block << " rate=" << r.sampleRate
+                              << ": " << r.nsPerSample << " ns/sample, baseline " << reference->second
+                              << " (+" << (r.nsPerSample / reference->second - 1.0) * 100 << "%)" << std::endl;
+                    failures++;
+                }
+
+                if (!baselinePath.empty() && reference == baseline.end() && limit == thresholds.end()) {
+                    std::cerr << (strict ? "FAIL " : "WARN ") << r.kernel << " block=" << r.block
+                              << " rate=" << r.sampleRate << ": tidak ada baseline maupun batas absolut" << std::endl;
+                    if (strict) failures++;
+                }
+            }
+        }
+    }
+
+    // Kernel yang diganti nama atau dihapus: baseline-nya tidak lagi menjaga apa pun
+    for (const auto& entry : unmeasured) {
+        std::cerr << (strict ? "FAIL " : "WARN ") << "baseline " << entry.first << ": kernel tidak diukur" << std::endl;
+        if (strict) failures++;
+    }
+
+    double overhead = measureInstrumentation();
+    std::cout << "{\"kernel\":\"instrumentation\",\"ns_per_callback\":" << overhead << "}" << std::endl;
+    auto limit = thresholds.find("instrumentation");
+    if (limit != thresholds.end() && overhead > limit->second) {
+        std::cerr << "FAIL instrumentation: " << overhead << " ns/callback > " << limit->second << std::endl;
+        failures++;
+    }
+
+    return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,397 @@
+#pragma once
+
+// Shared audio I/O for amp, ampg, mix and tuner.
+//
+// Every program keeps its PortAudio-style callback. The backend decides where
+// the buffers come from:
+//   - PortAudioBackend : the default sound card (original behaviour).
+//   - FileBackend      : reads a WAV file (or silence) into the same callback at
+//                        a fixed block size and optionally writes the output to
+//                        a WAV file. Runs in real time or as fast as possible,
+//                        so every DSP path can be replayed without a sound card.
+//
+// Both backends time every callback and count xruns into CallbackStats
+// (common/rt_stats.h); statusLine()/statsReport() expose the result.
+//
+// The backend is selected at startup from the environment:
+//   AUDIO_BACKEND  = portaudio (default) | file | null (file without any files)
+//   AUDIO_INPUT    = WAV file fed to the callback input (file backend, input streams only)
+//   AUDIO_OUTPUT   = WAV file receiving the callback output (file backend)
+//   AUDIO_REALTIME = 1 to pace blocks at the sample rate, 0 (default) for max speed
+//   AUDIO_DURATION = seconds of silent input to run without AUDIO_INPUT (default
+//                    10, 0 = no limit). Output-only streams (mix) end when the
+//                    callback returns paComplete and have no limit unless set.
+//
+// Sample rate and block size are chosen at startup (configureFromEnvironment):
+//   AUDIO_SAMPLE_RATE = requested rate in Hz (default: per program, 44100)
+//   AUDIO_BLOCK_SIZE  = frames per callback, 0 = derive from device latency
+// open() negotiates them with the device (or the input WAV file) and writes the
+// values actually used back into the AudioStreamConfig.
+
+#include <portaudio.h>
+#include <sndfile.h>
+#include "rt_stats.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+struct AudioStreamConfig {
+    int inputChannels = 0;
+    int outputChannels = 0;
+    double sampleRate = 44100;
+    unsigned long framesPerBuffer = 256;
+    PaStreamFlags flags = paNoFlag;
+};
+
+class AudioBackend {
+public:
+    virtual ~AudioBackend() = default;
+
+    // config diperbarui dengan sample rate / ukuran blok hasil negosiasi
+    virtual bool open(AudioStreamConfig& config, PaStreamCallback* callback, void* userData) = 0;
+    virtual bool start() = 0;
+    virtual bool stop() = 0;
+    virtual void close() = 0;
+    virtual bool isActive() const = 0;
+
+    // true jika tidak ada perangkat audio / terminal (CI, render server)
+    virtual bool isHeadless() const = 0;
+
+    // Fraksi waktu blok yang dipakai callback (0.0 - 1.0)
+    virtual double cpuLoad() const = 0;
+
+    const std::string& errorText() const { return error; }
+    const CallbackStats& stats() const { return callbackStats; }
+
+    std::string statusLine() const { return formatStatusLine(callbackStats.snapshot(), cpuLoad()); }
+    std::string statsReport() const { return formatStatsReport(callbackStats.snapshot(), cpuLoad()); }
+
+protected:
+    void setCallback(const AudioStreamConfig& config, PaStreamCallback* streamCallback, void* streamUserData) {
+        callback = streamCallback;
+        userData = streamUserData;
+        callbackStats.setDeadline(config.framesPerBuffer / config.sampleRate);
+    }
+
+    // Panggil callback program sambil mencatat durasi dan statusFlags
+    int invokeCallback(const void* input, void* output, unsigned long frames,
+                       const PaStreamCallbackTimeInfo* timeInfo, PaStreamCallbackFlags statusFlags) {
+        auto start = std::chrono::steady_clock::now();
+        int result = callback(input, output, frames, timeInfo, statusFlags, userData);
+        lastDurationNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        callbackStats.record(lastDurationNs, statusFlags);
+        return result;
+    }
+
+    static int trampoline(const void* input, void* output, unsigned long frames,
+                          const PaStreamCallbackTimeInfo* timeInfo, PaStreamCallbackFlags statusFlags,
+                          void* self) {
+        return static_cast<AudioBackend*>(self)->invokeCallback(input, output, frames, timeInfo, statusFlags);
+    }
+
+    std::string error;
+    PaStreamCallback* callback = nullptr;
+    void* userData = nullptr;
+    CallbackStats callbackStats;
+    uint64_t lastDurationNs = 0;
+};
+
+// **Backend PortAudio (sound card)**
+class PortAudioBackend : public AudioBackend {
+public:
+    ~PortAudioBackend() override { close(); }
+
+    bool open(AudioStreamConfig& config, PaStreamCallback* streamCallback, void* streamUserData) override {
+        PaError err = Pa_Initialize();
+        if (err != paNoError) return fail(err);
+        initialized = true;
+
+        PaStreamParameters inputParameters{};
+        PaStreamParameters outputParameters{};
+
+        if (config.inputChannels > 0) {
+            inputParameters.device = Pa_GetDefaultInputDevice();
+            if (inputParameters.device == paNoDevice) {
+                error = "Tidak ada perangkat input tersedia";
+                return false;
+            }
+            inputParameters.channelCount = config.inputChannels;
+            inputParameters.sampleFormat = paFloat32;
+            inputParameters.suggestedLatency = Pa_GetDeviceInfo(inputParameters.device)->defaultLowInputLatency;
+            inputParameters.hostApiSpecificStreamInfo = nullptr;
+        }
+
+        if (config.outputChannels > 0) {
+            outputParameters.device = Pa_GetDefaultOutputDevice();
+            if (outputParameters.device == paNoDevice) {
+                error = "Tidak ada perangkat output tersedia";
+                return false;
+            }
+            outputParameters.channelCount = config.outputChannels;
+            outputParameters.sampleFormat = paFloat32;
+            outputParameters.suggestedLatency = Pa_GetDeviceInfo(outputParameters.device)->defaultLowOutputLatency;
+            outputParameters.hostApiSpecificStreamInfo = nullptr;
+        }
+
+        const PaStreamParameters* input = config.inputChannels > 0 ? &inputParameters : nullptr;
+        const PaStreamParameters* output = config.outputChannels > 0 ? &outputParameters : nullptr;
+        const PaDeviceInfo* device = Pa_GetDeviceInfo(input ? input->device : output->device);
+
+        // **Negosiasi sample rate**: pakai default perangkat jika rate yang diminta tidak didukung
+        if (Pa_IsFormatSupported(input, output, config.sampleRate) != paFormatIsSupported) {
+            double requested = config.sampleRate;
+            config.sampleRate = device->defaultSampleRate;
+            if (Pa_IsFormatSupported(input, output, config.sampleRate) != paFormatIsSupported) {
+                error = "Sample rate " + std::to_string(static_cast<int>(requested)) + " tidak didukung perangkat";
+                return false;
+            }
+        }
+
+        // **Ukuran blok otomatis**: pangkat dua terdekat dengan latency rendah perangkat
+        if (config.framesPerBuffer == 0) {
+            double latency = input ? input->suggestedLatency : output->suggestedLatency;
+            config.framesPerBuffer = 32;
+            while (config.framesPerBuffer < 1024 && config.framesPerBuffer < latency * config.sampleRate) {
+                config.framesPerBuffer *= 2;
+            }
+        }
+
+        setCallback(config, streamCallback, streamUserData);
+        err = Pa_OpenStream(&stream, input, output,
+                            config.sampleRate, config.framesPerBuffer, config.flags,
+                            trampoline, this);
+        if (err != paNoError) {
+            stream = nullptr;
+            return fail(err);
+        }
+        return true;
+    }
+
+    bool start() override {
+        PaError err = Pa_StartStream(stream);
+        return err == paNoError || fail(err);
+    }
+
+    bool stop() override {
+        if (!stream) return true;
+        PaError err = Pa_StopStream(stream);
+        return err == paNoError || fail(err);
+    }
+
+    void close() override {
+        if (stream) {
+            Pa_CloseStream(stream);
+            stream = nullptr;
+        }
+        if (initialized) {
+            Pa_Terminate();
+            initialized = false;
+        }
+    }
+
+    bool isActive() const override { return stream && Pa_IsStreamActive(stream) == 1; }
+    bool isHeadless() const override { return false; }
+    double cpuLoad() const override { return stream ? Pa_GetStreamCpuLoad(stream) : 0.0; }
+
+private:
+    bool fail(PaError err) {
+        error = Pa_GetErrorText(err);
+        return false;
+    }
+
+    PaStream* stream = nullptr;
+    bool initialized = false;
+};
+
+// **Backend file/null (tanpa sound card, deterministik)**
+class FileBackend : public AudioBackend {
+public:
+    struct Options {
+        std::string inputPath;   // kosong = input berupa silence
+        std::string outputPath;  // kosong = output dibuang
+        bool realtime = false;
+        // Hanya tanpa input file, 0 = tanpa batas. Negatif = default: 10 detik untuk
+        // stream dengan input, tanpa batas untuk stream output saja (berhenti sendiri)
+        double durationSeconds = -1.0;
+    };
+
+    explicit FileBackend(Options options) : options(std::move(options)) {}
+    ~FileBackend() override { close(); }
+
+    bool open(AudioStreamConfig& streamConfig, PaStreamCallback* streamCallback, void* streamUserData) override {
+        // Stream tanpa input (mix) mengabaikan AUDIO_INPUT
+        if (!options.inputPath.empty() && streamConfig.inputChannels > 0) {
+            inputInfo = SF_INFO{};
+            infile = sf_open(options.inputPath.c_str(), SFM_READ, &inputInfo);
+            if (!infile) {
+                error = "Error opening " + options.inputPath + ": " + sf_strerror(nullptr);
+                return false;
+            }
+            // File input berperan sebagai perangkat: sample rate-nya yang dipakai
+            streamConfig.sampleRate = inputInfo.samplerate;
+        }
+
+        // Tanpa perangkat, ukuran blok otomatis = 256
+        if (streamConfig.framesPerBuffer == 0) streamConfig.framesPerBuffer = 256;
+
+        config = streamConfig;
+        setCallback(config, streamCallback, streamUserData);
+
+        if (!options.outputPath.empty() && config.outputChannels > 0) {
+            SF_INFO outputInfo{};
+            outputInfo.samplerate = static_cast<int>(config.sampleRate);
+            outputInfo.channels = config.outputChannels;
+            outputInfo.format = SF_FORMAT_WAV | SF_FORMAT_FLOAT;
+            outfile = sf_open(options.outputPath.c_str(), SFM_WRITE, &outputInfo);
+            if (!outfile) {
+                error = "Error creating " + options.outputPath + ": " + sf_strerror(nullptr);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool start() override {
+        if (worker.joinable()) worker.join();
+        stopRequested = false;
+        running = true;
+        worker = std::thread(&FileBackend::run, this);
+        return true;
+    }
+
+    bool stop() override {
+        stopRequested = true;
+        if (worker.joinable()) worker.join();
+        return true;
+    }
+
+    void close() override {
+        stop();
+        if (infile) {
+            sf_close(infile);
+            infile = nullptr;
+        }
+        if (outfile) {
+            sf_close(outfile);
+            outfile = nullptr;
+        }
+    }
+
+    bool isActive() const override { return running; }
+    bool isHeadless() const override { return true; }
+    double cpuLoad() const override { return load; }
+
+private:
+    void run() {
+        const unsigned long frames = config.framesPerBuffer;
+        const int fileChannels = infile ? inputInfo.channels : 0;
+        std::vector<float> fileBuffer(frames * fileChannels);
+        std::vector<float> in(frames * config.inputChannels, 0.0f);
+        std::vector<float> out(frames * config.outputChannels, 0.0f);
+
+        double durationSeconds = options.durationSeconds;
+        if (durationSeconds < 0) durationSeconds = config.inputChannels > 0 ? 10.0 : 0.0;
+        const long long maxFrames = static_cast<long long>(durationSeconds * config.sampleRate);
+        const auto startTime = std::chrono::steady_clock::now();
+        long long framesDone = 0;
+
+        while (!stopRequested) {
+            unsigned long valid = frames;
+
+            if (infile) {
+                valid = static_cast<unsigned long>(sf_readf_float(infile, fileBuffer.data(), frames));
+                if (valid == 0) break;
+                // Blok terakhir diisi nol supaya callback selalu menerima ukuran tetap
+                std::fill(in.begin(), in.end(), 0.0f);
+                for (unsigned long i = 0; i < valid; i++) {
+                    for (int c = 0; c < config.inputChannels; c++) {
+                        in[i * config.inputChannels + c] = fileBuffer[i * fileChannels + std::min(c, fileChannels - 1)];
+                    }
+                }
+            } else if (maxFrames > 0 && framesDone >= maxFrames) {
+                break;
+            }
+
+            PaStreamCallbackTimeInfo timeInfo{};
+            timeInfo.currentTime = framesDone / config.sampleRate;
+            timeInfo.inputBufferAdcTime = timeInfo.currentTime;
+            timeInfo.outputBufferDacTime = timeInfo.currentTime;
+
+            int result = invokeCallback(config.inputChannels > 0 ? in.data() : nullptr,
+                                        config.outputChannels > 0 ? out.data() : nullptr,
+                                        frames, &timeInfo, 0);
+
+            // Rata-rata bergerak seperti Pa_GetStreamCpuLoad
+            load = 0.9 * load + 0.1 * (lastDurationNs / (frames * 1e9 / config.sampleRate));
+
+            if (outfile) sf_writef_float(outfile, out.data(), valid);
+            framesDone += frames;
+
+            if (result != paContinue) break;
+
+            if (options.realtime) {
+                std::this_thread::sleep_until(startTime + std::chrono::duration<double>(framesDone / config.sampleRate));
+            }
+        }
+        running = false;
+    }
+
+    Options options;
+    AudioStreamConfig config;
+
+    SNDFILE* infile = nullptr;
+    SNDFILE* outfile = nullptr;
+    SF_INFO inputInfo{};
+
+    std::thread worker;
+    std::atomic<bool> running{false};
+    std::atomic<bool> stopRequested{false};
+    std::atomic<double> load{0.0};
+};
+
+// **Pilih backend dari environment (lihat keterangan di atas)**
+inline std::unique_ptr<AudioBackend> createAudioBackend() {
+    auto env = [](const char* name) {
+        const char* value = std::getenv(name);
+        return std::string(value ? value : "");
+    };
+
+    std::string backend = env("AUDIO_BACKEND");
+    if (backend == "file" || backend == "null") {
+        FileBackend::Options options;
+        if (backend == "file") {
+            options.inputPath = env("AUDIO_INPUT");
+            options.outputPath = env("AUDIO_OUTPUT");
+        }
+        options.realtime = env("AUDIO_REALTIME") == "1";
+        if (!env("AUDIO_DURATION").empty()) options.durationSeconds = std::atof(env("AUDIO_DURATION").c_str());
+        return std::make_unique<FileBackend>(options);
+    }
+    return std::make_unique<PortAudioBackend>();
+}
+
+// Ganti sample rate / ukuran blok default program dari environment (lihat keterangan di atas)
+inline void configureFromEnvironment(AudioStreamConfig& config) {
+    if (const char* rate = std::getenv("AUDIO_SAMPLE_RATE")) {
+        double value = std::atof(rate);
+        if (value > 0) config.sampleRate = value;
+    }
+    if (const char* block = std::getenv("AUDIO_BLOCK_SIZE")) {
+        long value = std::atol(block);
+        if (value >= 0) config.framesPerBuffer = static_cast<unsigned long>(value);
+    }
+}
+
+// Tunggu sampai stream selesai (input file habis atau callback mengembalikan paComplete)
+inline void waitForStream(const AudioBackend& audio) {
+    while (audio.isActive()) {
+        usleep(10000);
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+// Fast path untuk ukuran blok pangkat dua yang umum (32-1024).
+//
+// Kernel ditulis sebagai template atas tipe `Frames`, yang berupa
+// std::integral_constant (jumlah frame diketahui saat compile, loop bisa
+// di-unroll penuh) atau unsigned long (jalur generik untuk ukuran lain):
+//
+//   dispatchBlockSize(framesPerBuffer, [&](auto frames) {
+//       processAmpBlock(in, out, frames, ...);
+//   });
+//
+// Untuk buffer interleaved, dispatchChannels menjadikan jumlah kanal (mono,
+// stereo) faktor compile-time kedua; blockSamples(frames, channels) lalu
+// menghasilkan FixedBlock<frames * channels> bila keduanya tetap.
+
+#include <type_traits>
+
+template <unsigned long N>
+using FixedBlock = std::integral_constant<unsigned long, N>;
+
+template <typename Fn>
+inline void dispatchBlockSize(unsigned long frames, Fn&& fn) {
+    switch (frames) {
+        case 32:   fn(FixedBlock<32>()); break;
+        case 64:   fn(FixedBlock<64>()); break;
+        case 128:  fn(FixedBlock<128>()); break;
+        case 256:  fn(FixedBlock<256>()); break;
+        case 512:  fn(FixedBlock<512>()); break;
+        case 1024: fn(FixedBlock<1024>()); break;
+        default:   fn(frames); break;
+    }
+}
+
+template <int C>
+using FixedChannels = std::integral_constant<int, C>;
+
+template <typename Fn>
+inline void dispatchChannels(int channels, Fn&& fn) {
+    switch (channels) {
+        case 1:  fn(FixedChannels<1>()); break;
+        case 2:  fn(FixedChannels<2>()); break;
+        default: fn(channels); break;
+    }
+}
+
+// Jumlah sampel interleaved dalam satu blok
+template <unsigned long N, int C>
+inline FixedBlock<N * C> blockSamples(FixedBlock<N>, FixedChannels<C>) {
+    return {};
+}
+
+inline unsigned long blockSamples(unsigned long frames, int channels) {
+    return frames * channels;
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+// Telemetri real-time untuk callback audio: histogram durasi callback,
+// penghitung xrun dari statusFlags, dan persentil (p50/p99/max).
+//
+// record() hanya dipanggil oleh thread audio (single writer) dan hanya memakai
+// load/store atomic relaxed, tanpa lock dan tanpa alokasi. snapshot() boleh
+// dipanggil dari thread UI kapan saja.
+
+#include <portaudio.h>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+class CallbackStats {
+public:
+    // 16 bucket linear untuk 0-15 ns, lalu 8 sub-bucket per pangkat dua (presisi ~12%)
+    static const int kLinearBuckets = 16;
+    static const int kSubBuckets = 8;
+    static const int kBuckets = kLinearBuckets + (64 - 4) * kSubBuckets;
+
+    struct Snapshot {
+        uint64_t callbacks = 0;
+        uint64_t p50Ns = 0;
+        uint64_t p99Ns = 0;
+        uint64_t maxNs = 0;
+        uint64_t inputUnderflows = 0;
+        uint64_t inputOverflows = 0;
+        uint64_t outputUnderflows = 0;
+        uint64_t outputOverflows = 0;
+        double deadlineNs = 0.0;
+    };
+
+    // Durasi satu blok audio (framesPerBuffer / sampleRate)
+    void setDeadline(double seconds) { deadlineNs = seconds * 1e9; }
+
+    void record(uint64_t durationNs, PaStreamCallbackFlags statusFlags) {
+        bump(histogram[bucketFor(durationNs)]);
+        if (durationNs > maxNs.load(std::memory_order_relaxed)) {
+            maxNs.store(durationNs, std::memory_order_relaxed);
+        }
+
+        if (statusFlags) {
+            if (statusFlags & paInputUnderflow) bump(inputUnderflows);
+            if (statusFlags & paInputOverflow) bump(inputOverflows);
+            if (statusFlags & paOutputUnderflow) bump(outputUnderflows);
+            if (statusFlags & paOutputOverflow) bump(outputOverflows);
+        }
+    }
+
+    Snapshot snapshot() const {
+        Snapshot s;
+        uint64_t counts[kBuckets];
+        for (int i = 0; i < kBuckets; i++) {
+            counts[i] = histogram[i].load(std::memory_order_relaxed);
+            s.callbacks += counts[i];
+        }
+        s.p50Ns = percentile(counts, s.callbacks, 0.50);
+        s.p99Ns = percentile(counts, s.callbacks, 0.99);
+        s.maxNs = maxNs.load(std::memory_order_relaxed);
+        s.inputUnderflows = inputUnderflows.load(std::memory_order_relaxed);
+        s.inputOverflows = inputOverflows.load(std::memory_order_relaxed);
+        s.outputUnderflows = outputUnderflows.load(std::memory_order_relaxed);
+        s.outputOverflows = outputOverflows.load(std::memory_order_relaxed);
+        s.deadlineNs = deadlineNs;
+        return s;
+    }
+
+    static int bucketFor(uint64_t ns) {
+        if (ns < kLinearBuckets) return static_cast<int>(ns);
+        int exponent = 63 - __builtin_clzll(ns);  // >= 4
+        int sub = static_cast<int>((ns >> (exponent - 3)) & (kSubBuckets - 1));
+        return kLinearBuckets + (exponent - 4) * kSubBuckets + sub;
+    }
+
+    // Batas atas bucket (nilai yang dilaporkan untuk persentil)
+    static uint64_t bucketUpperBound(int bucket) {
+        if (bucket < kLinearBuckets) return static_cast<uint64_t>(bucket);
+        int exponent = (bucket - kLinearBuckets) / kSubBuckets + 4;
+        uint64_t sub = static_cast<uint64_t>((bucket - kLinearBuckets) % kSubBuckets);
+        uint64_t step = 1ull << (exponent - 3);
+        return (1ull << exponent) + (sub + 1) * step - 1;
+    }
+
+private:
+    // Single writer: load + store lebih murah daripada fetch_add
+    static void bump(std::atomic<uint64_t>& counter) {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    static uint64_t percentile(const uint64_t* counts, uint64_t total, double p) {
+        if (total == 0) return 0;
+        uint64_t rank = static_cast<uint64_t>(p * total);
+        if (rank == 0) rank = 1;
+        uint64_t seen = 0;
+        for (int i = 0; i < kBuckets; i++) {
+            seen += counts[i];
+            if (seen >= rank) return bucketUpperBound(i);
+        }
+        return bucketUpperBound(kBuckets - 1);
+    }
+
+    std::atomic<uint64_t> histogram[kBuckets] = {};
+    std::atomic<uint64_t> maxNs{0};
+    std::atomic<uint64_t> inputUnderflows{0};
+    std::atomic<uint64_t> inputOverflows{0};
+    std::atomic<uint64_t> outputUnderflows{0};
+    std::atomic<uint64_t> outputOverflows{0};
+    double deadlineNs = 0.0;
+};
+
+// Satu baris status untuk UI ncurses/CLI
+inline std::string formatStatusLine(const CallbackStats::Snapshot& s, double cpuLoad) {
+    char line[192];
+    std::snprintf(line, sizeof(line),
+                  "cb p50 %.1fus p99 %.1fus max %.1fus / %.0fus | xrun in %llu out %llu | cpu %.1f%%",
+                  s.p50Ns / 1e3, s.p99Ns / 1e3, s.maxNs / 1e3, s.deadlineNs / 1e3,
+                  static_cast<unsigned long long>(s.inputUnderflows + s.inputOverflows),
+                  static_cast<unsigned long long>(s.outputUnderflows + s.outputOverflows),
+                  cpuLoad * 100.0);
+    return line;
+}
+
+// Ringkasan lengkap, dicetak saat program berhenti
+inline std::string formatStatsReport(const CallbackStats::Snapshot& s, double cpuLoad) {
+    char report[512];
+    std::snprintf(report, sizeof(report),
+                  "Callbacks     : %llu\n"
+                  "Durasi p50    : %.1f us\n"
+                  "Durasi p99    : %.1f us\n"
+                  "Durasi max    : %.1f us (deadline %.1f us)\n"
+                  "Input  xrun   : %llu underflow, %llu overflow\n"
+                  "Output xrun   : %llu underflow, %llu overflow\n"
+                  "CPU load      : %.1f%%\n",
+                  static_cast<unsigned long long>(s.callbacks),
+                  s.p50Ns / 1e3, s.p99Ns / 1e3, s.maxNs / 1e3, s.deadlineNs / 1e3,
+                  static_cast<unsigned long long>(s.inputUnderflows),
+                  static_cast<unsigned long long>(s.inputOverflows),
+                  static_cast<unsigned long long>(s.outputUnderflows),
+                  static_cast<unsigned long long>(s.outputOverflows),
+                  cpuLoad * 100.0);
+    return report;
+}
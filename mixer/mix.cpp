@@ -2,37 +2,28 @@
 #include <vector>
 #include <sndfile.h>
 #include <portaudio.h>
+#include "../common/audio_io.h"
+#include "mix_dsp.h"
 
-#define SAMPLE_RATE 44100
 #define FRAMES_PER_BUFFER 512
 
-struct AudioData {
-    std::vector<float> buffer1;
-    std::vector<float> buffer2;
-    std::vector<float> outputBuffer;
-    size_t index = 0;
-};
-
 static int audioCallback(const void* inputBuffer, void* outputBuffer,
                          unsigned long framesPerBuffer,
                          const PaStreamCallbackTimeInfo* timeInfo,
                          PaStreamCallbackFlags statusFlags,
                          void* userData) {
-    AudioData* data = (AudioData*)userData;
+    MixerData* data = (MixerData*)userData;
     float* out = (float*)outputBuffer;
     
-    for (unsigned long i = 0; i < framesPerBuffer * 2; ++i) {
-        if (data->index < data->buffer1.size() && data->index < data->buffer2.size()) {
-            float mixedSample = (data->buffer1[data->index] * 0.5f) + (data->buffer2[data->index] * 0.5f);
-            out[i] = mixedSample;
-            data->outputBuffer.push_back(mixedSample);
-            data->index++;
-        } else {
-            out[i] = 0.0f;
-        }
-    }
-    
-    return paContinue;
+    bool playing = true;
+    dispatchBlockSize(framesPerBuffer, [&](auto frames) {
+        dispatchChannels(data->channels, [&](auto channels) {
+            playing = mixBlock(*data, out, frames, channels);
+        });
+    });
+
+    // Selesai setelah kedua file habis diputar
+    return playing ? paContinue : paComplete;
 }
 
 void mixAndSaveAudio(const std::string& file1, const std::string& file2, const std::string& output) {
@@ -50,7 +41,8 @@ void mixAndSaveAudio(const std::string& file1, const std::string& file2, const s
         return;
     }
     
-    AudioData audioData;
+    MixerData audioData;
+    audioData.channels = sfinfo1.channels;
     int frames = std::min(sfinfo1.frames, sfinfo2.frames);
     audioData.buffer1.resize(frames * sfinfo1.channels);
     audioData.buffer2.resize(frames * sfinfo2.channels);
@@ -61,17 +53,46 @@ void mixAndSaveAudio(const std::string& file1, const std::string& file2, const s
     sf_close(infile1);
     sf_close(infile2);
     
-    Pa_Initialize();
-    PaStream* stream;
-    Pa_OpenDefaultStream(&stream, 0, sfinfo1.channels, paFloat32, SAMPLE_RATE, FRAMES_PER_BUFFER, audioCallback, &audioData);
-    Pa_StartStream(stream);
+    // Reservasi di sini supaya push_back di callback tidak pernah realokasi
+    audioData.outputBuffer.reserve(audioData.buffer1.size());
+    
+    auto audio = createAudioBackend();
+    AudioStreamConfig config;
+    config.outputChannels = sfinfo1.channels;
+    config.framesPerBuffer = FRAMES_PER_BUFFER;
+    configureFromEnvironment(config);
+    config.sampleRate = sfinfo1.samplerate;  // Selalu putar sesuai sample rate file
+    
+    if (!audio->open(config, audioCallback, &audioData)) {
+        std::cerr << "Error opening stream: " << audio->errorText() << std::endl;
+        return;
+    }
+    
+    // PortAudio jatuh ke sample rate default perangkat jika rate file tidak didukung;
+    // mix tidak me-resample, jadi playback akan salah pitch dan tempo
+    if (config.sampleRate != sfinfo1.samplerate) {
+        std::cerr << "Device does not support " << sfinfo1.samplerate << " Hz (stream opened at "
+                  << config.sampleRate << " Hz); resampling is not supported." << std::endl;
+        audio->close();
+        return;
+    }
+    
+    if (!audio->start()) {
+        std::cerr << "Error starting stream: " << audio->errorText() << std::endl;
+        audio->close();
+        return;
+    }
     
-    std::cout << "Playing mixed audio... Press Enter to stop." << std::endl;
-    std::cin.get();
+    if (audio->isHeadless()) {
+        waitForStream(*audio);
+    } else {
+        std::cout << "Playing mixed audio... Press Enter to stop." << std::endl;
+        std::cin.get();
+    }
     
-    Pa_StopStream(stream);
-    Pa_CloseStream(stream);
-    Pa_Terminate();
+    audio->stop();
+    std::cout << audio->statsReport();
+    audio->close();
     
     // Save mixed audio to file
     SF_INFO sfinfoOut = sfinfo1;
@@ -85,7 +106,11 @@ void mixAndSaveAudio(const std::string& file1, const std::string& file2, const s
     sf_writef_float(outfile, audioData.outputBuffer.data(), audioData.outputBuffer.size() / sfinfo1.channels);
     sf_close(outfile);
     
-    std::cout << "Playback finished. Output saved to " << output << std::endl;
+    if (audioData.outputBuffer.size() < audioData.buffer1.size()) {
+        std::cout << "Playback stopped early. Partial output saved to " << output << std::endl;
+    } else {
+        std::cout << "Playback finished. Output saved to " << output << std::endl;
+    }
 }
 
 int main(int argc, char* argv[]) {
@@ -0,0 +1,56 @@
+#pragma once
+
+// DSP mix.cpp: dipakai oleh callback dan oleh bench/bench.cpp
+#include <algorithm>
+#include <vector>
+#include "../common/block_size.h"
+
+struct MixerData {
+    std::vector<float> buffer1;
+    std::vector<float> buffer2;
+    std::vector<float> outputBuffer;
+    size_t index = 0;
+    int channels = 1;
+};
+
+// Rata-rata dua sinyal; tanpa state, jadi bisa di-unroll/vektorisasi.
+// __restrict: out tidak pernah tumpang-tindih dengan buffer file, dan tanpa itu
+// -O2 tidak mau memvektorisasi (butuh cek alias saat runtime).
+template <typename Count>
+inline void mixSamples(const float* __restrict a, const float* __restrict b, float* __restrict out,
+                       Count samples) {
+    const unsigned long count = samples;  // Konstanta compile-time untuk FixedBlock
+#pragma GCC unroll 8
+    for (unsigned long i = 0; i < count; i++) {
+        out[i] = (a[i] * 0.5f) + (b[i] * 0.5f);
+    }
+}
+
+// Campur satu blok (frames x channels sampel interleaved) ke out, sisa diisi
+// silence. Mengembalikan false jika kedua file sudah habis. (Frames, Channels:
+// lihat common/block_size.h; fast path berlaku untuk blok 32-1024 mono/stereo.)
+// Selama masih ada satu blok penuh, jumlah iterasi tetap, jadi FixedBlock
+// menghasilkan loop dengan panjang tetap; hanya blok terakhir lewat jalur sisa.
+template <typename Frames, typename Channels>
+inline bool mixBlock(MixerData& data, float* out, Frames frames, Channels channels) {
+    const auto samples = blockSamples(frames, channels);
+    const size_t length = std::min(data.buffer1.size(), data.buffer2.size());
+    const size_t available = length - data.index;
+    const float* a = data.buffer1.data() + data.index;
+    const float* b = data.buffer2.data() + data.index;
+
+    size_t mixed;
+    if (available >= samples) {
+        mixSamples(a, b, out, samples);
+        mixed = samples;
+    } else {
+        mixSamples(a, b, out, available);
+        std::fill(out + available, out + samples, 0.0f);
+        mixed = available;
+    }
+
+    // outputBuffer sudah di-reserve sepanjang buffer1, jadi insert tidak realokasi
+    data.outputBuffer.insert(data.outputBuffer.end(), out, out + mixed);
+    data.index += mixed;
+    return data.index < length;
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+// DSP tuner.cpp: dipakai oleh callback dan oleh bench/bench.cpp
+#include <algorithm>
+#include <cmath>
+#include <fftw3.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#define FFT_WINDOW_MS 46.44  // 2048 sampel pada 44.1 kHz
+
+// **Daftar nada standar (frekuensi referensi)**
+static const std::map<std::string, float> notes = {
+    {"C", 16.35}, {"C#", 17.32}, {"D", 18.35}, {"D#", 19.45}, {"E", 20.60},
+    {"F", 21.83}, {"F#", 23.12}, {"G", 24.50}, {"G#", 25.96}, {"A", 27.50},
+    {"A#", 29.14}, {"B", 30.87}
+};
+
+// **Menentukan nada dan oktaf berdasarkan frekuensi**
+inline std::pair<std::string, int> getClosestNoteWithOctave(float freq) {
+    std::string closestNote = "?";
+    float minDiff = 1e9;
+    int octave = 0;
+
+    for (int o = 0; o <= 8; o++) { // Oktaf dari 0 sampai 8
+        for (const auto& pair : notes) {
+            float noteFreq = pair.second * pow(2, o);
+            float diff = std::abs(freq - noteFreq);
+            if (diff < minDiff) {
+                minDiff = diff;
+                closestNote = pair.first;
+                octave = o;
+            }
+        }
+    }
+    return {closestNote, octave};
+}
+
+// Ukuran FFT pangkat dua yang paling dekat dengan FFT_WINDOW_MS
+inline int fftSizeFor(double sampleRate) {
+    double target = FFT_WINDOW_MS * sampleRate / 1000;
+    int size = 256;
+    while (size * M_SQRT2 < target) size *= 2;
+    return size;
+}
+
+struct TunerState {
+    explicit TunerState(double rate = 44100)
+        : sampleRate(rate), fftSize(fftSizeFor(rate)), audioData(fftSize, 0.0f) {}
+
+    double sampleRate;
+    int fftSize;
+    std::vector<float> audioData;
+    int sampleIndex = 0;
+};
+
+// Simpan data untuk FFT, true jika window fftSize sudah penuh lagi.
+// Jika ukuran blok tidak membagi fftSize, window berisi fftSize sampel terakhir
+// dalam urutan yang diputar; magnitudo FFT tidak berubah oleh rotasi itu.
+// Disalin per potongan sampai batas window, tanpa cabang per sampel.
+inline bool collectSamples(TunerState& state, const float* in, unsigned long frames) {
+    bool full = false;
+    while (frames > 0) {
+        unsigned long count = std::min<unsigned long>(frames, state.fftSize - state.sampleIndex);
+        std::copy(in, in + count, state.audioData.begin() + state.sampleIndex);
+        in += count;
+        frames -= count;
+        state.sampleIndex += count;
+        if (state.sampleIndex == state.fftSize) {
+            state.sampleIndex = 0;
+            full = true;
+        }
+    }
+    return full;
+}
+
+// **FFT lalu cari frekuensi dominan**
+inline float detectPeakFrequency(const TunerState& state) {
+    fftw_complex* out;
+    fftw_plan plan;
+    out = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * state.fftSize);
+
+    // **Konversi float ke double untuk FFTW3**
+    std::vector<double> audioDataDouble(state.audioData.begin(), state.audioData.end());
+
+    plan = fftw_plan_dft_r2c_1d(state.fftSize, audioDataDouble.data(), out, FFTW_ESTIMATE);
+    fftw_execute(plan);
+
+    int peakIndex = 0;
+    double peakMagnitude = 0.0;
+    for (int i = 1; i < state.fftSize / 2; i++) {
+        double magnitude = sqrt(out[i][0] * out[i][0] + out[i][1] * out[i][1]);
+        if (magnitude > peakMagnitude) {
+            peakMagnitude = magnitude;
+            peakIndex = i;
+        }
+    }
+
+    fftw_destroy_plan(plan);
+    fftw_free(out);
+
+    return (float)(peakIndex * state.sampleRate / state.fftSize);
+}
@@ -4,10 +4,11 @@
 #include <cmath>
 #include <vector>
 #include <map>
+#include "../common/audio_io.h"
+#include "tuner_dsp.h"
 
 #define SAMPLE_RATE 44100
 #define FRAMES_PER_BUFFER 1024
-#define FFT_SIZE 2048
 
 class TunerComponent : public juce::Component, public juce::Timer
 {
@@ -121,8 +122,8 @@ private:
     };
 
     std::unique_ptr<MainWindow> mainWindow;
-    PaStream* stream;
-    std::vector<float> audioData;
+    std::unique_ptr<AudioBackend> audio;
+    TunerState tunerState;
     TunerComponent* tunerComponent = nullptr;
 
     static int audioCallback(const void* inputBuffer, void* outputBuffer,
@@ -135,59 +136,44 @@ private:
         if (!inputBuffer) return paContinue;
 
         const float* in = static_cast<const float*>(inputBuffer);
-        for (unsigned long i = 0; i < framesPerBuffer; i++) {
-            app->audioData[i] = in[i];
-        }
+        bool windowFull = collectSamples(app->tunerState, in, framesPerBuffer);
 
-        fftw_complex* out;
-        fftw_plan plan;
-        out = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * FFT_SIZE);
-
-        std::vector<double> audioDataDouble(app->audioData.begin(), app->audioData.end());
-        plan = fftw_plan_dft_r2c_1d(FFT_SIZE, audioDataDouble.data(), out, FFTW_ESTIMATE);
-        fftw_execute(plan);
-
-        int peakIndex = 0;
-        double peakMagnitude = 0.0;
-        for (int i = 1; i < FFT_SIZE / 2; i++) {
-            double magnitude = sqrt(out[i][0] * out[i][0] + out[i][1] * out[i][1]);
-            if (magnitude > peakMagnitude) {
-                peakMagnitude = magnitude;
-                peakIndex = i;
-            }
+        if (windowFull && app->tunerComponent) {
+            app->tunerComponent->updateFrequency(detectPeakFrequency(app->tunerState));
         }
 
-        float peakFrequency = (float)peakIndex * SAMPLE_RATE / FFT_SIZE;
-        if (app->tunerComponent) {
-            app->tunerComponent->updateFrequency(peakFrequency);
-        }
-
-        fftw_destroy_plan(plan);
-        fftw_free(out);
-
         return paContinue;
     }
 
     void startAudio()
     {
-        Pa_Initialize();
-        PaStreamParameters inputParameters;
-        inputParameters.device = Pa_GetDefaultInputDevice();
-        inputParameters.channelCount = 1;
-        inputParameters.sampleFormat = paFloat32;
-        inputParameters.suggestedLatency = Pa_GetDeviceInfo(inputParameters.device)->defaultLowInputLatency;
-        inputParameters.hostApiSpecificStreamInfo = nullptr;
-
-        audioData.resize(FFT_SIZE, 0.0f);
-        Pa_OpenStream(&stream, &inputParameters, nullptr, SAMPLE_RATE, FRAMES_PER_BUFFER, paClipOff, audioCallback, this);
-        Pa_StartStream(stream);
+        audio = createAudioBackend();
+
+        AudioStreamConfig config;
+        config.inputChannels = 1;
+        config.sampleRate = SAMPLE_RATE;
+        config.framesPerBuffer = FRAMES_PER_BUFFER;
+        config.flags = paClipOff;
+        configureFromEnvironment(config);
+
+        if (!audio->open(config, audioCallback, this)) {
+            juce::Logger::writeToLog("Error membuka stream: " + juce::String(audio->errorText()));
+            return;
+        }
+
+        tunerState = TunerState(config.sampleRate);
+        if (!audio->start()) {
+            juce::Logger::writeToLog("Error memulai stream: " + juce::String(audio->errorText()));
+        }
     }
 
     void stopAudio()
     {
-        Pa_StopStream(stream);
-        Pa_CloseStream(stream);
-        Pa_Terminate();
+        if (audio) {
+            audio->stop();
+            juce::Logger::writeToLog(juce::String(audio->statsReport()));
+            audio->close();
+        }
     }
 };
 